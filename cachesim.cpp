@@ -1,6 +1,7 @@
 #include "cachesim.hpp"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 /************** Structure Definitions **************/
@@ -13,49 +14,54 @@ struct tag {
     struct tag *next;
 };
 
-struct translation {
-    uint64_t vpn;
-    uint64_t pfn;
-    char valid;
-    struct translation *next;
-    struct translation *prev;
-    // Parent is corresponding translation in hwivpt for tlb, not used by hwivpt
-    struct translation *parent;
-};
-// All of the translations will be allocated in a block at these locations
-struct translation *tlb_translations;
-struct translation *hwivpt_translations;
+// Marks a link to no translation, like a null pointer
+static const uint32_t NIL = UINT32_MAX;
+// Marks a translation that has never been filled; no real VPN is this large
+static const uint64_t INVALID_VPN = UINT64_MAX;
 
+// Translations are stored as parallel arrays indexed by entry, with 32-bit
+// indices as links. An HWIVPT entry's index is its PFN. A TLB entry's PFN is
+// the index of its parent HWIVPT entry, so it doubles as the parent link.
 struct translation_storage {
-    struct translation *mru;
-    struct translation *lru;
-} tlb, hwivpt;
+    uint64_t *vpn;
+    uint32_t *next;
+    uint32_t *prev;
+    uint32_t *pfn; // TLB only
+    uint32_t mru;
+    uint32_t lru;
+};
 
 struct set {
     struct tag *mru;
 };
 
 struct tag_store {
-    struct set **sets;
-} tag_store;
+    struct set *sets;
+};
 
 /************** Global Variables **************/
 
-int num_ways;
-int num_sets;
-int num_pages;
-int num_tlb_entries;
-bool vipt;
-int s;
-int m;
-uint64_t index_mask;
-uint64_t index_position;
-uint64_t tag_mask;
-uint64_t tag_position;
-uint64_t offset_mask;
-uint64_t offset_position;
-uint64_t vpn_mask;
-uint64_t vpn_position;
+// Simulator state is per thread so the sweep server can run one
+// configuration on each of its workers at the same time
+
+thread_local struct translation_storage tlb, hwivpt;
+thread_local struct tag_store tag_store;
+
+thread_local int num_ways;
+thread_local int num_sets;
+thread_local int num_pages;
+thread_local int num_tlb_entries;
+thread_local bool vipt;
+thread_local int s;
+thread_local int m;
+thread_local uint64_t index_mask;
+thread_local uint64_t index_position;
+thread_local uint64_t tag_mask;
+thread_local uint64_t tag_position;
+thread_local uint64_t offset_mask;
+thread_local uint64_t offset_position;
+thread_local uint64_t vpn_mask;
+thread_local uint64_t vpn_position;
 
 /************** Setup Functions **************/
 
@@ -68,8 +74,8 @@ void configure_user_setup(sim_config_t *config) {
     num_ways = 1 << config->s;
     // cache size in bytes divided by (block size in bytes times blocks per set)
     num_sets = 1 << (config->c - (config->b + config->s));
+    vipt = config->vipt;
     if (config->vipt) {
-        vipt = true;
         num_pages = 1 << config->m;
         num_tlb_entries = 1 << config->t;
     }
@@ -80,11 +86,7 @@ void configure_user_setup(sim_config_t *config) {
  */
 void allocate_l1(void) {
     // Allocate a block of memory to store all of the sets
-    tag_store.sets = (struct set**)calloc(num_sets, sizeof(struct set*));
-    // allocate sets and store pointers in the array of sets
-    for (int i = 0; i < num_sets; i++) {
-        tag_store.sets[i] = (struct set*)calloc(1, sizeof(struct set));
-    }
+    tag_store.sets = (struct set*)calloc(num_sets, sizeof(struct set));
 }
 
 /**
@@ -109,18 +111,25 @@ void configure_bit_tools(sim_config_t *config) {
 /**
  * Request dynamic memory for the either the TLB or the HWIVPT
  */
-struct translation *initialize_translation_storage(struct translation_storage *store, uint64_t size) {
-    // unlike cache, allocate all tlb and hwivpt entries
-    struct translation *translations_base = (struct translation *)calloc(size, sizeof(struct translation));
-    for (uint64_t i = 0; i < (size - 1); i++) {
-        translations_base[i].pfn = i;
-        translations_base[i].next = &(translations_base[i + 1]);
-        translations_base[i + 1].prev = &(translations_base[i]);
-    }
-    store->mru = translations_base;
-    store->lru = &(translations_base[size - 1]);
-    store->lru->pfn = size - 1;
-    return translations_base;
+void initialize_translation_storage(struct translation_storage *store, uint32_t size, bool has_pfn) {
+    // unlike cache, allocate all tlb and hwivpt entries, in one block
+    uint64_t link_words = (has_pfn ? 3 : 2) * (uint64_t)size;
+    store->vpn = (uint64_t *)malloc(size * sizeof(uint64_t) + link_words * sizeof(uint32_t));
+    store->next = (uint32_t *)(store->vpn + size);
+    store->prev = store->next + size;
+    store->pfn = has_pfn ? store->prev + size : 0;
+    for (uint32_t i = 0; i < size; i++) {
+        store->vpn[i] = INVALID_VPN;
+        store->next[i] = i + 1;
+        store->prev[i] = i - 1;
+        if (has_pfn) {
+            store->pfn[i] = 0;
+        }
+    }
+    store->prev[0] = NIL;
+    store->next[size - 1] = NIL;
+    store->mru = 0;
+    store->lru = size - 1;
 }
 
 /************** L1 Cache Helper Functions **************/
@@ -184,7 +193,7 @@ void update_set_mru(struct set *set, struct tag *tag, sim_stats_t *stats) {
  */
 void flush_cache(sim_stats_t *stats) {
     for (int i = 0; i < num_sets; i++) {
-        struct tag *active_way = tag_store.sets[i]->mru;
+        struct tag *active_way = tag_store.sets[i].mru;
         while (active_way != 0) {
             if (stats) {
                 if (active_way->dirty) {
@@ -195,7 +204,7 @@ void flush_cache(sim_stats_t *stats) {
             free(active_way);
             active_way = next;
         }
-        tag_store.sets[i]->mru = 0;
+        tag_store.sets[i].mru = 0;
     }
 }
 
@@ -204,70 +213,70 @@ void flush_cache(sim_stats_t *stats) {
 /**
  * Search for a virtual page number in either the TLB or HWIVPT
  */
-struct translation *search_for_translation(struct translation_storage *store, uint64_t vpn) {
-    struct translation *mapping = store->mru;
-    while (mapping != 0) {
-        if (mapping->vpn == vpn && mapping->valid) {
+uint32_t search_for_translation(struct translation_storage *store, uint64_t vpn) {
+    uint32_t mapping = store->mru;
+    while (mapping != NIL) {
+        if (store->vpn[mapping] == vpn) {
             return mapping;
         }
-        mapping = mapping->next;
+        mapping = store->next[mapping];
     }
-    return 0;
+    return NIL;
 }
 
 /**
  * Update the MRU in either the TLB or HWIVPT based on a recent access
  */
-void update_translation_mru(struct translation_storage *store, struct translation *mapping) {
-    if (mapping == 0) {
-        return;
-    }
-    if (mapping->prev == 0) {
+void update_translation_mru(struct translation_storage *store, uint32_t mapping) {
+    uint32_t prev = store->prev[mapping];
+    if (prev == NIL) {
         // Already in the MRU position
         return;
     }
     // Remove from current position
-    mapping->prev->next = mapping->next;
-    if (mapping->next == 0) {
+    uint32_t next = store->next[mapping];
+    store->next[prev] = next;
+    if (next == NIL) {
         // Was at the LRU position
-        store->lru = mapping->prev;
+        store->lru = prev;
     } else {
-        mapping->next->prev = mapping->prev;
+        store->prev[next] = prev;
     }
     // Place at mru
-    store->mru->prev = mapping;
-    mapping->next = store->mru;
-    mapping->prev = 0;
+    store->prev[store->mru] = mapping;
+    store->next[mapping] = store->mru;
+    store->prev[mapping] = NIL;
     store->mru = mapping;
 }
 
 /**
- * Insert a translation in either the TLB or HWIVPT using the LRU frame
+ * Insert a translation in either the TLB or HWIVPT using the LRU frame, and
+ * return the frame used
  */
-void insert_translation(struct translation_storage *store, int64_t vpn, int64_t pfn, struct translation *parent) {
-    struct translation *victim = store->lru;
-    victim->valid = 1;
-    victim->vpn = vpn;
-    victim->pfn = pfn;
-    victim->parent = parent;
+uint32_t insert_translation(struct translation_storage *store, uint64_t vpn, uint32_t pfn) {
+    uint32_t victim = store->lru;
+    store->vpn[victim] = vpn;
+    if (store->pfn) {
+        store->pfn[victim] = pfn;
+    }
     update_translation_mru(store, victim);
+    return victim;
 }
 
 /**
  * Look for a translation in the TLB, return -1 if not found
  */
 int64_t search_tlb(uint64_t addr) {
-    int64_t vpn = (addr & vpn_mask) >> vpn_position;
-    int64_t pfn = -1;
-    struct translation *tlb_mapping = search_for_translation(&tlb, vpn);
-    if (tlb_mapping == 0) {
+    uint64_t vpn = (addr & vpn_mask) >> vpn_position;
+    uint32_t tlb_mapping = search_for_translation(&tlb, vpn);
+    if (tlb_mapping == NIL) {
         // Translation wasn't found
         return -1;
     }
-    pfn = tlb_mapping->pfn;
+    uint32_t pfn = tlb.pfn[tlb_mapping];
     // Update lru stack in both tlb and hwivpt
     update_translation_mru(&tlb, tlb_mapping);
-    update_translation_mru(&hwivpt, tlb_mapping->parent);
+    update_translation_mru(&hwivpt, pfn);
     return pfn;
 }
 
@@ -275,18 +284,16 @@ int64_t search_tlb(uint64_t addr) {
  * Look for a translation in the HWIVPT, return -1 if not found
  */
 int64_t search_hwivpt(uint64_t addr) {
-    int64_t vpn = (addr & vpn_mask) >> vpn_position;
-    int64_t pfn = -1;
-    struct translation *hwivpt_mapping = search_for_translation(&hwivpt, vpn);
-    if (hwivpt_mapping == 0) {
+    uint64_t vpn = (addr & vpn_mask) >> vpn_position;
+    uint32_t pfn = search_for_translation(&hwivpt, vpn);
+    if (pfn == NIL) {
         // Translation wasn't found
         return -1;
     }
-    pfn = hwivpt_mapping->pfn;
     // Insert translation into tlb
     // Update lru stack in both tlb and hwivpt
-    update_translation_mru(&hwivpt, hwivpt_mapping);
-    insert_translation(&tlb, vpn, pfn, hwivpt_mapping);
+    update_translation_mru(&hwivpt, pfn);
+    insert_translation(&tlb, vpn, pfn);
     return pfn;
 }
 
@@ -295,13 +302,63 @@ int64_t search_hwivpt(uint64_t addr) {
  * the TLB and HWIVPT
  */
 int64_t page_fault_handler(uint64_t addr) {
-    int64_t vpn = (addr & vpn_mask) >> vpn_position;
-    insert_translation(&hwivpt, vpn, hwivpt.lru->pfn, 0);
-    int64_t pfn = hwivpt.mru->pfn;
-    insert_translation(&tlb, vpn, pfn, hwivpt.mru);
+    uint64_t vpn = (addr & vpn_mask) >> vpn_position;
+    uint32_t pfn = insert_translation(&hwivpt, vpn, 0);
+    insert_translation(&tlb, vpn, pfn);
+    return pfn;
+}
+
+/**
+ * Translate addr through the TLB, then the HWIVPT. Returns -1 on a page fault,
+ * leaving addr virtual
+ */
+int64_t translate_address(uint64_t *addr, sim_stats_t *stats) {
+    stats->accesses_tlb++;
+    int64_t pfn = search_tlb(*addr);
+    if (pfn < 0) {
+        // Translation not in TLB
+        stats->misses_tlb++;
+
+        stats->accesses_hw_ivpt++;
+        pfn = search_hwivpt(*addr);
+        if (pfn < 0) {
+            stats->misses_hw_ivpt++;
+            return -1;
+        }
+        stats->hits_hw_ivpt++;
+    } else {
+        stats->hits_tlb++;
+    }
+    *addr = (pfn << vpn_position) | (*addr & ~vpn_mask);
     return pfn;
 }
 
+/************** Statistics Helper Functions **************/
+
+/**
+ * Fill in the ratios and average access time from the raw counts
+ */
+void calculate_statistics(sim_stats_t *stats) {
+    stats->hit_ratio_l1 = (double)stats->hits_l1 / stats->accesses_l1;
+    stats->miss_ratio_l1 = (double)stats->misses_l1 / stats->accesses_l1;
+    double tag_compare_time = L1_TAG_COMPARE_TIME_CONST + s * L1_TAG_COMPARE_TIME_PER_S;
+    double hit_time = L1_ARRAY_LOOKUP_TIME_CONST + tag_compare_time;
+    double miss_penalty = DRAM_ACCESS_PENALTY;
+
+    if (vipt) {
+        stats->hit_ratio_tlb = (double)stats->hits_tlb / stats->accesses_tlb;
+        stats->miss_ratio_tlb = (double)stats->misses_tlb / stats->accesses_tlb;
+        stats->hit_ratio_hw_ivpt = (double)stats->hits_hw_ivpt / stats->accesses_hw_ivpt;
+        stats->miss_ratio_hw_ivpt = (double)stats->misses_hw_ivpt / stats->accesses_hw_ivpt;
+        double hwivpt_penalty = (1 + HW_IVPT_ACCESS_TIME_PER_M * m) * DRAM_ACCESS_PENALTY;
+        hit_time = (L1_ARRAY_LOOKUP_TIME_CONST +
+            stats->hit_ratio_tlb * tag_compare_time +
+            stats->miss_ratio_tlb * (hwivpt_penalty + tag_compare_time * stats->hit_ratio_hw_ivpt));
+    }
+
+    stats->avg_access_time = hit_time + stats->miss_ratio_l1 * miss_penalty;
+}
+
 /**
  * The use of virtually indexed physically tagged caches limits 
  *      the total number of sets you can have.
@@ -316,6 +373,44 @@ void legalize_s(sim_config_t *config) {
     }
 }
 
+/**
+ * Check that a configuration is reasonable to simulate. Returns a description
+ * of the first problem found, or 0 if the configuration is valid.
+ */
+const char *sim_config_error(sim_config_t *config) {
+    if (config->b > 7 || config->b < 4) {
+        return "The block size must be reasonable: 4 <= B <= 7";
+    }
+
+    if (config->c > 18 || config->c < 9) {
+        return "The cache size must be reasonable: 9 <= C <= 18";
+    }
+
+    if (config->s > config->c - config->b) {
+        return "The set associativity must be reasonable: 0 <= S <= C - B";
+    }
+
+    if (config->vipt) {
+        if (config->p < 9 || config->p > 14 || config->p > config->c) {
+            return "The page size must be reasonable: 9 <= P <= min(14, C)";
+        }
+
+        if (config->t > (config->c - config->b - config->s)) {
+            return "The TLB must have a reasonable number of entries: 0 <= T <= C - B - S";
+        }
+
+        if (config->m < config->p || config->m > 20) {
+            return "Do not simulate too few/many pages in memory: P <= M <= 20";
+        }
+
+        if (config->m + config->p > 32) {
+            return "Do not simulate too much memory (4GB): 0 <= M <= 32 - P";
+        }
+    }
+
+    return 0;
+}
+
 /**
  * Subroutine for initializing the cache simulator. You many add and initialize any global or heap
  * variables as needed.
@@ -325,8 +420,8 @@ void sim_setup(sim_config_t *config) {
     allocate_l1();
     configure_bit_tools(config);
     if (config->vipt) {
-        tlb_translations = initialize_translation_storage(&tlb, num_tlb_entries);
-        hwivpt_translations = initialize_translation_storage(&hwivpt, num_pages);
+        initialize_translation_storage(&tlb, num_tlb_entries, true);
+        initialize_translation_storage(&hwivpt, num_pages, false);
     }
 }
 
@@ -337,29 +432,11 @@ void sim_access(char rw, uint64_t addr, sim_stats_t* stats) {
     stats->accesses_l1++;
     uint64_t index = (addr & index_mask) >> index_position;
     stats->array_lookups_l1++;
-    struct set *active_set = tag_store.sets[index];
+    struct set *active_set = &tag_store.sets[index];
     int64_t pfn = -1;
 
     if (vipt) {
-        stats->accesses_tlb++;
-        pfn = search_tlb(addr);
-        if (pfn < 0) {
-            // Translation not in TLB
-            stats->misses_tlb++;
-
-            stats->accesses_hw_ivpt++;
-            pfn = search_hwivpt(addr);
-            if (pfn < 0) {
-                stats->misses_hw_ivpt++;
-            } else {
-                stats->hits_hw_ivpt++;
-                addr = (pfn << vpn_position) | (addr & ~vpn_mask);
-            }
-
-        } else {
-            stats->hits_tlb++;
-            addr = (pfn << vpn_position) | (addr & ~vpn_mask);
-        }
+        pfn = translate_address(&addr, stats);
     }
 
     uint64_t tag = (addr & tag_mask) >> tag_position;
@@ -402,35 +479,139 @@ void sim_access(char rw, uint64_t addr, sim_stats_t* stats) {
  * such as miss rate or average access time.
  */
 void sim_finish(sim_stats_t *stats) {
-    stats->hit_ratio_l1 = (double)stats->hits_l1 / stats->accesses_l1;
-    stats->miss_ratio_l1 = (double)stats->misses_l1 / stats->accesses_l1;
-    double tag_compare_time = L1_TAG_COMPARE_TIME_CONST + s * L1_TAG_COMPARE_TIME_PER_S;
-    double hit_time = L1_ARRAY_LOOKUP_TIME_CONST + tag_compare_time;
-    double miss_penalty = DRAM_ACCESS_PENALTY;
+    calculate_statistics(stats);
+
+    // Free the tag store
+    flush_cache(0);
+    free(tag_store.sets);
 
     if (vipt) {
-        stats->hit_ratio_tlb = (double)stats->hits_tlb / stats->accesses_tlb;
-        stats->miss_ratio_tlb = (double)stats->misses_tlb / stats->accesses_tlb;
-        stats->hit_ratio_hw_ivpt = (double)stats->hits_hw_ivpt / stats->accesses_hw_ivpt;
-        stats->miss_ratio_hw_ivpt = (double)stats->misses_hw_ivpt / stats->accesses_hw_ivpt;
-        double hwivpt_penalty = (1 + HW_IVPT_ACCESS_TIME_PER_M * m) * DRAM_ACCESS_PENALTY;
-        hit_time = (L1_ARRAY_LOOKUP_TIME_CONST +
-            stats->hit_ratio_tlb * tag_compare_time +
-            stats->miss_ratio_tlb * (hwivpt_penalty + tag_compare_time * stats->hit_ratio_hw_ivpt));
+        // Free the virtual address translations
+        free(tlb.vpn);
+        free(hwivpt.vpn);
     }
+}
 
-    stats->avg_access_time = hit_time + stats->miss_ratio_l1 * miss_penalty;
+/************** Lockstep Direct Mapped Simulation **************/
 
-    // Free the tag store
-    flush_cache(0);
-    for (int i = 0; i < num_sets; i++) {
-        free(tag_store.sets[i]);
+// One element per lane. GCC and Clang lower these to the widest SIMD
+// registers the target has, splitting them if need be.
+typedef uint64_t lane_vec __attribute__((vector_size(LOCKSTEP_LANES * sizeof(uint64_t))));
+// What comparing two lane_vecs gives: all ones in the lanes where it holds
+typedef int64_t lane_mask __attribute__((vector_size(LOCKSTEP_LANES * sizeof(int64_t))));
+
+// A direct mapped set holds a single line, packed as tag << 2 | dirty | valid
+static const uint64_t LINE_VALID = 1;
+static const uint64_t LINE_DIRTY = 2;
+static const uint64_t LINE_TAG_POSITION = 2;
+
+/**
+ * Whether two configurations can share a lockstep pass. Lanes share the TLB
+ * and HWIVPT, so VIPT configurations must agree on P, T, and M.
+ */
+bool sim_lockstep_compatible(sim_config_t *a, sim_config_t *b) {
+    if (a->s != 0 || b->s != 0 || a->vipt != b->vipt) {
+        return false;
     }
-    free(tag_store.sets);
+    return !a->vipt || (a->p == b->p && a->t == b->t && a->m == b->m);
+}
 
+/**
+ * Simulate up to LOCKSTEP_LANES direct mapped configurations over a whole
+ * trace, producing the same statistics as separate runs of sim_access
+ */
+void sim_lockstep(sim_config_t *configs, int num_configs, const trace_t *trace, sim_stats_t *stats) {
+    // Per lane address slicing, and where each lane's lines start in the
+    // shared line array. Idle lanes get a single line of their own.
+    lane_vec block_shift, tag_shift, set_mask, base;
+    uint64_t total_lines = 0;
+    for (int l = 0; l < LOCKSTEP_LANES; l++) {
+        bool active = l < num_configs;
+        block_shift[l] = active ? configs[l].b : 0;
+        tag_shift[l] = active ? configs[l].c : 0;
+        set_mask[l] = active ? (1ULL << (configs[l].c - configs[l].b)) - 1 : 0;
+        base[l] = total_lines;
+        total_lines += set_mask[l] + 1;
+    }
+    uint64_t *lines = (uint64_t *)calloc(total_lines, sizeof(uint64_t));
+
+    // The translation state is the same for every lane, so keep one copy
+    configure_user_setup(&configs[0]);
+    configure_bit_tools(&configs[0]);
     if (vipt) {
-        // Free the virtual address translations
-        free(tlb_translations);
-        free(hwivpt_translations);
+        initialize_translation_storage(&tlb, num_tlb_entries, true);
+        initialize_translation_storage(&hwivpt, num_pages, false);
+    }
+
+    // Counts that do not depend on C or B are kept once
+    sim_stats_t common;
+    memset(&common, 0, sizeof common);
+    const lane_vec zero = {};
+    lane_vec hits = {};
+    lane_vec writebacks = {};
+    lane_vec flush_writebacks = {};
+
+    for (uint64_t i = 0; i < trace->length; i++) {
+        uint64_t addr = trace->accesses[i].addr;
+        char rw = trace->accesses[i].rw;
+        common.accesses_l1++;
+        common.array_lookups_l1++;
+        lane_vec slot = base + ((addr + zero) >> block_shift & set_mask);
+        lane_vec line;
+        for (int l = 0; l < LOCKSTEP_LANES; l++) {
+            line[l] = lines[slot[l]];
+        }
+
+        int64_t pfn = -1;
+        if (vipt) {
+            pfn = translate_address(&addr, &common);
+        }
+        if (vipt && pfn < 0) {
+            // Page fault!! Every lane flushes, so there is nothing to hit or evict
+            for (int l = 0; l < LOCKSTEP_LANES; l++) {
+                for (uint64_t j = base[l]; j <= base[l] + set_mask[l]; j++) {
+                    flush_writebacks[l] += (lines[j] & LINE_DIRTY) >> 1;
+                    lines[j] = 0;
+                }
+            }
+            line = zero;
+            pfn = page_fault_handler(addr);
+            addr = (pfn << vpn_position) | (addr & ~vpn_mask);
+        } else {
+            common.tag_compares_l1++;
+        }
+
+        lane_vec tag = (addr + zero) >> tag_shift;
+        lane_mask hit = ((line >> LINE_TAG_POSITION) == tag) & ((line & LINE_VALID) != 0);
+        hits += (lane_vec)hit & 1;
+        // A miss evicts whatever was in the set
+        writebacks += (lane_vec)~hit & (line & LINE_DIRTY) >> 1;
+
+        uint64_t dirty = 0;
+        if (rw == 'W') {
+            common.writes++;
+            dirty = LINE_DIRTY;
+        } else if (rw == 'R') {
+            common.reads++;
+        }
+        line = (tag << LINE_TAG_POSITION) | ((lane_vec)hit & line & LINE_DIRTY) | dirty | LINE_VALID;
+        for (int l = 0; l < LOCKSTEP_LANES; l++) {
+            lines[slot[l]] = line[l];
+        }
+    }
+
+    for (int l = 0; l < num_configs; l++) {
+        stats[l] = common;
+        stats[l].hits_l1 = hits[l];
+        stats[l].misses_l1 = common.accesses_l1 - hits[l];
+        stats[l].writebacks_l1 = writebacks[l];
+        stats[l].cache_flush_writebacks = flush_writebacks[l];
+        calculate_statistics(&stats[l]);
+    }
+
+    free(lines);
+    if (vipt) {
+        free(tlb.vpn);
+        free(hwivpt.vpn);
     }
 }
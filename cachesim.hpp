@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "trace.hpp"
 
 typedef struct sim_config {
     // (C,B,S) in the Conte Cache Taxonomy (Patent Pending)
@@ -15,6 +16,8 @@ typedef struct sim_config {
     uint64_t m; // log2(number of pages in memory)
 } sim_config_t;
 
+// The sweep server replies with these fields in declaration order; keep
+// STATS_FIELDS in sweep_client.py in step when adding or reordering them
 typedef struct sim_stats {
     uint64_t reads;                 // read requests
     uint64_t writes;                // write requests
@@ -41,10 +44,18 @@ typedef struct sim_stats {
 } sim_stats_t;
 
 extern void legalize_s(sim_config_t *config);
+extern const char *sim_config_error(sim_config_t *config);
 extern void sim_setup(sim_config_t *config);
 extern void sim_access(char rw, uint64_t addr, sim_stats_t* p_stats);
 extern void sim_finish(sim_stats_t *p_stats);
 
+// Direct mapped configurations that differ only in C and B can be simulated
+// side by side in one pass over a trace, one SIMD lane per configuration.
+// Configurations must be legalized, valid, and each compatible with the first.
+static const int LOCKSTEP_LANES = 8;
+extern bool sim_lockstep_compatible(sim_config_t *a, sim_config_t *b);
+extern void sim_lockstep(sim_config_t *configs, int num_configs, const trace_t *trace, sim_stats_t *stats);
+
 // Sorry about the /* comments */. C++11 cannot handle basic C99 syntax,
 // unfortunately
 static const sim_config_t DEFAULT_SIM_CONFIG = {
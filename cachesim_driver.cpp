@@ -4,6 +4,8 @@
 #include <string.h>
 #include <unistd.h>
 #include "cachesim.hpp"
+#include "trace.hpp"
+#include "cachesim_server.hpp"
 
 static void print_help(void);
 static int validate_config(sim_config_t *config);
@@ -13,10 +15,13 @@ static void print_statistics(sim_stats_t* stats, sim_config_t *sim_config);
 
 int main(int argc, char **argv) {
     sim_config_t config = DEFAULT_SIM_CONFIG;
+    unsigned parse_threads = 0;
+    unsigned server_workers = 0;
+    const char *server_socket = 0;
     int opt;
 
     /* Read arguments */
-    while(-1 != (opt = getopt(argc, argv, "c:b:s:p:t:m:vh"))) {
+    while(-1 != (opt = getopt(argc, argv, "c:b:s:p:t:m:j:S:w:vh"))) {
         switch(opt) {
         case 'c': // c
             config.c = atoi(optarg);
@@ -39,6 +44,15 @@ int main(int argc, char **argv) {
         case 'm': // log2 num pages in phys mem
             config.m = atoi(optarg);
             break;
+        case 'j': // trace parser threads
+            parse_threads = atoi(optarg);
+            break;
+        case 'S': // sweep server socket
+            server_socket = optarg;
+            break;
+        case 'w': // sweep server workers
+            server_workers = atoi(optarg);
+            break;
         case 'h':
             /* Fall through */
         default:
@@ -47,6 +61,10 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (server_socket) {
+        return run_server(server_socket, server_workers, parse_threads);
+    }
+
     if (config.vipt) printf("Initital ");
     printf("Cache Settings\n");
     printf("--------------\n");
@@ -82,12 +100,21 @@ int main(int argc, char **argv) {
     memset(&stats, 0, sizeof stats);
 
     /* Begin reading the file */
-    char rw;
-    uint64_t address;
-    while (!feof(stdin)) {
-        int ret = fscanf(stdin, "%c 0x%" PRIx64 "\n", &rw, &address);
-        if(ret == 2) {
-            sim_access(rw, address, &stats);
+    trace_t trace;
+    if (trace_parse_fd(fileno(stdin), parse_threads, &trace) == 0) {
+        for (uint64_t i = 0; i < trace.length; i++) {
+            sim_access(trace.accesses[i].rw, trace.accesses[i].addr, &stats);
+        }
+        trace_free(&trace);
+    } else {
+        // stdin is a pipe or too big to decode up front, scan it as it arrives
+        char rw;
+        uint64_t address;
+        while (!feof(stdin)) {
+            int ret = fscanf(stdin, "%c 0x%" PRIx64 "\n", &rw, &address);
+            if(ret == 2) {
+                sim_access(rw, address, &stats);
+            }
         }
     }
 
@@ -111,42 +138,19 @@ static void print_help(void) {
     printf("  -t T\t\tNumber of entries in the TLB is 2^T\n");
     printf("  -m M\t\tNumber of Pages in Memory is 2^M (same as entries in HWIVPT)\n");
     printf("  -D   \t\tDisable L2 cache\n");
+    printf("Trace parsing:\n");
+    printf("  -j J\t\tUse J threads to parse the trace (default: one per core)\n");
+    printf("Sweep server:\n");
+    printf("  -S PATH\tServe queries on Unix domain socket PATH instead of reading stdin\n");
+    printf("  -w W\t\tRun queries on W worker threads (default: one per core)\n");
 }
 
 static int validate_config(sim_config_t *config) {
-    if (config->b > 7 || config->b < 4) {
-        printf("Invalid configuration! The block size must be reasonable: 4 <= B <= 7\n");
+    const char *error = sim_config_error(config);
+    if (error) {
+        printf("Invalid configuration! %s\n", error);
         return 1;
     }
-
-    if (config->c > 18 || config->c < 9) {
-        printf("Invalid configuration! The cache size must be reasonable: 9 <= C <= 18\n");
-        return 1;
-    }
-
-    if (config->vipt) {
-        if (config->p < 9 || config->p > 14 || config->p > config->c) {
-            printf("Invalid configuration! The page size must be reasonable: 9 <= P <= min(14, C)\n");
-            return 1;
-        }
-
-        if (config->t > (config->c - config->b - config->s)) {
-            printf("Invalid configuration! The TLB must have a reasonable number of entries: 0 <= T <= C - B - S\n");
-            return 1;
-        }
-
-        if (config->m < config->p || config->m > 20) {
-            printf("Invalid configuration! Do not simulate too few/many pages in memory: P <= M <= 20\n");
-            return 1;
-        }
-
-        if (config->m + config->p > 32) {
-            printf("Invalid configuration! Do not simulate too much memory (4GB): 0 <= M <= 32 - P\n");
-            return 1;
-        }
-    }
-    
-
     return 0;
 }
 
@@ -0,0 +1,456 @@
+#include "cachesim_server.hpp"
+#include "cachesim.hpp"
+#include "trace.hpp"
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Line based protocol, one command per line:
+ *
+ *   LOAD <name> [path]     decode a trace (default ./traces/<name>.trace)
+ *                          -> "OK <accesses>" or "ERR <reason>"
+ *   UNLOAD <name>          drop a trace -> "OK" or "ERR <reason>"
+ *   SIM <name> <c> <b> <s> <vipt> <p> <t> <m>
+ *                          queue a query against a loaded trace, no reply
+ *   RUN                    run every queued query on the worker pool, then
+ *                          reply one line per query in the order queued
+ *                          (direct mapped queries on the same trace are
+ *                          simulated several at a time in lockstep):
+ *                          "OK" and every sim_stats_t field in declaration
+ *                          order, or "ERR <reason>"
+ *   QUIT                   close the connection
+ *
+ * VIPT queries have S legalized exactly as the command line driver does.
+ * sweep_client.py is the Python client and names the reply fields.
+ */
+
+/************** Structure Definitions **************/
+
+// A decoded trace, freed once no connection or query refers to it
+struct resident_trace {
+    trace_t trace;
+    ~resident_trace() { trace_free(&trace); }
+};
+
+struct query {
+    std::shared_ptr<resident_trace> trace;
+    sim_config_t config;
+    sim_stats_t stats;
+    const char *error;
+};
+
+struct batch {
+    std::vector<struct query> queries;
+    size_t remaining;
+    std::mutex lock;
+    std::condition_variable finished;
+};
+
+// One query, or several direct mapped queries to simulate in lockstep
+struct job {
+    struct batch *batch;
+    std::vector<size_t> indices;
+};
+
+/************** Global Variables **************/
+
+static unsigned trace_parse_threads;
+
+static std::mutex traces_lock;
+static std::map<std::string, std::shared_ptr<resident_trace> > traces;
+
+static std::mutex jobs_lock;
+static std::condition_variable jobs_ready;
+static std::deque<struct job> jobs;
+
+/************** Worker Pool **************/
+
+/**
+ * Legalize and validate a query before it is scheduled
+ */
+static void check_query(struct query *query) {
+    if (query->error) {
+        return;
+    }
+    if (query->config.vipt) {
+        legalize_s(&query->config);
+    }
+    query->error = sim_config_error(&query->config);
+}
+
+/**
+ * Simulate one configuration against its trace on the calling thread
+ */
+static void run_query(struct query *query) {
+    memset(&query->stats, 0, sizeof query->stats);
+    sim_setup(&query->config);
+    const trace_t *trace = &query->trace->trace;
+    for (uint64_t i = 0; i < trace->length; i++) {
+        sim_access(trace->accesses[i].rw, trace->accesses[i].addr, &query->stats);
+    }
+    sim_finish(&query->stats);
+}
+
+/**
+ * Simulate a group of compatible direct mapped queries in one pass
+ */
+static void run_lockstep(struct batch *batch, const std::vector<size_t> &indices) {
+    sim_config_t configs[LOCKSTEP_LANES];
+    sim_stats_t stats[LOCKSTEP_LANES];
+    for (size_t l = 0; l < indices.size(); l++) {
+        configs[l] = batch->queries[indices[l]].config;
+    }
+    sim_lockstep(configs, indices.size(), &batch->queries[indices[0]].trace->trace, stats);
+    for (size_t l = 0; l < indices.size(); l++) {
+        batch->queries[indices[l]].stats = stats[l];
+    }
+}
+
+/**
+ * Pull queries off the shared queue forever
+ */
+static void worker_main(void) {
+    while (true) {
+        struct job job;
+        {
+            std::unique_lock<std::mutex> guard(jobs_lock);
+            jobs_ready.wait(guard, []() { return !jobs.empty(); });
+            job = jobs.front();
+            jobs.pop_front();
+        }
+
+        if (job.indices.size() == 1) {
+            run_query(&job.batch->queries[job.indices[0]]);
+        } else {
+            run_lockstep(job.batch, job.indices);
+        }
+
+        std::lock_guard<std::mutex> guard(job.batch->lock);
+        job.batch->remaining -= job.indices.size();
+        if (job.batch->remaining == 0) {
+            job.batch->finished.notify_all();
+        }
+    }
+}
+
+/**
+ * Hand every query in a batch to the pool and wait for all of them
+ */
+static void run_batch(struct batch *batch) {
+    std::vector<struct query> &queries = batch->queries;
+    std::vector<bool> scheduled(queries.size(), false);
+    std::vector<struct job> pending;
+    for (size_t i = 0; i < queries.size(); i++) {
+        check_query(&queries[i]);
+    }
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (queries[i].error || scheduled[i]) {
+            continue;
+        }
+        struct job job = {batch, std::vector<size_t>(1, i)};
+        // Fill the remaining lanes with later queries that can share the pass
+        size_t lanes = (queries[i].config.s == 0) ? LOCKSTEP_LANES : 1;
+        for (size_t j = i + 1; j < queries.size() && job.indices.size() < lanes; j++) {
+            if (!queries[j].error && !scheduled[j] && queries[j].trace == queries[i].trace &&
+                    sim_lockstep_compatible(&queries[i].config, &queries[j].config)) {
+                scheduled[j] = true;
+                job.indices.push_back(j);
+            }
+        }
+        pending.push_back(job);
+    }
+
+    batch->remaining = 0;
+    for (size_t i = 0; i < pending.size(); i++) {
+        batch->remaining += pending[i].indices.size();
+    }
+    if (batch->remaining == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(jobs_lock);
+        for (size_t i = 0; i < pending.size(); i++) {
+            jobs.push_back(pending[i]);
+        }
+    }
+    jobs_ready.notify_all();
+
+    std::unique_lock<std::mutex> guard(batch->lock);
+    batch->finished.wait(guard, [batch]() { return batch->remaining == 0; });
+}
+
+/************** Trace Management **************/
+
+/**
+ * Decode a trace and make it available under name, replacing any previous one
+ */
+static void load_trace(FILE *out, const char *name, const char *path) {
+    std::string default_path = std::string("./traces/") + name + ".trace";
+    if (path == 0) {
+        path = default_path.c_str();
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(out, "ERR cannot open %s\n", path);
+        return;
+    }
+    std::shared_ptr<resident_trace> loaded(new resident_trace());
+    int ret = trace_parse_fd(fd, trace_parse_threads, &loaded->trace);
+    close(fd);
+    if (ret != 0) {
+        fprintf(out, "ERR cannot decode %s (not a regular file, or out of memory)\n", path);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(traces_lock);
+    traces[name] = loaded;
+    fprintf(out, "OK %" PRIu64 "\n", loaded->trace.length);
+}
+
+static void unload_trace(FILE *out, const char *name) {
+    std::lock_guard<std::mutex> guard(traces_lock);
+    if (traces.erase(name) == 0) {
+        fprintf(out, "ERR no trace named %s\n", name);
+        return;
+    }
+    fprintf(out, "OK\n");
+}
+
+static std::shared_ptr<resident_trace> find_trace(const char *name) {
+    std::lock_guard<std::mutex> guard(traces_lock);
+    auto found = traces.find(name);
+    if (found == traces.end()) {
+        return std::shared_ptr<resident_trace>();
+    }
+    return found->second;
+}
+
+/************** Connection Handling **************/
+
+static void print_stats_line(FILE *out, sim_stats_t *stats) {
+    fprintf(out, "OK %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64
+        " %" PRIu64 " %" PRIu64 " %" PRIu64 " %.17g %.17g",
+        stats->reads, stats->writes, stats->accesses_l1, stats->array_lookups_l1,
+        stats->tag_compares_l1, stats->hits_l1, stats->misses_l1, stats->writebacks_l1,
+        stats->hit_ratio_l1, stats->miss_ratio_l1);
+    fprintf(out, " %" PRIu64 " %" PRIu64 " %" PRIu64 " %.17g %.17g",
+        stats->accesses_tlb, stats->hits_tlb, stats->misses_tlb,
+        stats->hit_ratio_tlb, stats->miss_ratio_tlb);
+    fprintf(out, " %" PRIu64 " %" PRIu64 " %" PRIu64 " %.17g %.17g",
+        stats->accesses_hw_ivpt, stats->hits_hw_ivpt, stats->misses_hw_ivpt,
+        stats->hit_ratio_hw_ivpt, stats->miss_ratio_hw_ivpt);
+    fprintf(out, " %" PRIu64 " %.17g\n", stats->cache_flush_writebacks, stats->avg_access_time);
+}
+
+/**
+ * Parse a SIM command into a query, marking it with an error if malformed
+ */
+static void queue_query(struct batch *batch, const char *args) {
+    char name[256];
+    unsigned vipt = 0;
+    struct query query;
+    query.config = DEFAULT_SIM_CONFIG;
+    query.error = 0;
+    int ret = sscanf(args, "%255s %" SCNu64 " %" SCNu64 " %" SCNu64 " %u %" SCNu64 " %" SCNu64 " %" SCNu64,
+        name, &query.config.c, &query.config.b, &query.config.s, &vipt,
+        &query.config.p, &query.config.t, &query.config.m);
+    query.config.vipt = vipt;
+    if (ret != 8) {
+        query.error = "usage: SIM <name> <c> <b> <s> <vipt> <p> <t> <m>";
+    } else {
+        query.trace = find_trace(name);
+        if (!query.trace) {
+            query.error = "trace not loaded";
+        }
+    }
+    batch->queries.push_back(query);
+}
+
+static void handle_connection(int fd) {
+    FILE *in = fdopen(fd, "r");
+    int out_fd = dup(fd);
+    FILE *out = (out_fd < 0) ? 0 : fdopen(out_fd, "w");
+    if (in == 0 || out == 0) {
+        // Out of descriptors or memory, drop the client rather than the server
+        perror("fdopen");
+        if (out != 0) fclose(out); else if (out_fd >= 0) close(out_fd);
+        if (in != 0) fclose(in); else close(fd);
+        return;
+    }
+    char *line = 0;
+    size_t line_size = 0;
+    struct batch batch;
+
+    while (getline(&line, &line_size, in) > 0) {
+        char command[16];
+        char name[256];
+        char path[4096];
+        int consumed = 0;
+        if (sscanf(line, "%15s%n", command, &consumed) != 1) {
+            continue;
+        }
+        const char *args = line + consumed;
+
+        if (strcmp(command, "SIM") == 0) {
+            queue_query(&batch, args);
+            continue;
+        } else if (strcmp(command, "RUN") == 0) {
+            run_batch(&batch);
+            for (size_t i = 0; i < batch.queries.size(); i++) {
+                if (batch.queries[i].error) {
+                    fprintf(out, "ERR %s\n", batch.queries[i].error);
+                } else {
+                    print_stats_line(out, &batch.queries[i].stats);
+                }
+            }
+            batch.queries.clear();
+        } else if (strcmp(command, "LOAD") == 0) {
+            int ret = sscanf(args, "%255s %4095s", name, path);
+            if (ret < 1) {
+                fprintf(out, "ERR usage: LOAD <name> [path]\n");
+            } else {
+                load_trace(out, name, (ret == 2) ? path : 0);
+            }
+        } else if (strcmp(command, "UNLOAD") == 0) {
+            if (sscanf(args, "%255s", name) != 1) {
+                fprintf(out, "ERR usage: UNLOAD <name>\n");
+            } else {
+                unload_trace(out, name);
+            }
+        } else if (strcmp(command, "QUIT") == 0) {
+            break;
+        } else {
+            fprintf(out, "ERR unknown command %s\n", command);
+        }
+        fflush(out);
+    }
+
+    free(line);
+    fclose(out);
+    fclose(in);
+}
+
+/************** Socket Setup **************/
+
+/**
+ * Clear the way to bind socket_path. Only a socket nobody is listening on is
+ * removed; any other file there is left alone and reported as an error.
+ */
+static int remove_stale_socket(const char *socket_path, struct sockaddr_un *addr) {
+    struct stat st;
+    if (lstat(socket_path, &st) != 0) {
+        // Nothing there yet
+        return 0;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        fprintf(stderr, "Refusing to replace %s: it exists and is not a socket\n", socket_path);
+        return 1;
+    }
+
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe < 0) {
+        perror("socket");
+        return 1;
+    }
+    int live = connect(probe, (struct sockaddr *)addr, sizeof *addr) == 0;
+    close(probe);
+    if (live) {
+        fprintf(stderr, "A server is already listening on %s\n", socket_path);
+        return 1;
+    }
+    if (unlink(socket_path) != 0) {
+        perror(socket_path);
+        return 1;
+    }
+    return 0;
+}
+
+// Bounds on how long to wait before accepting again when out of descriptors
+// or memory, doubling while it persists
+static const int ACCEPT_BACKOFF_MIN_MS = 10;
+static const int ACCEPT_BACKOFF_MAX_MS = 1000;
+
+/************** Public Interface **************/
+
+int run_server(const char *socket_path, unsigned num_workers, unsigned parse_threads) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof addr.sun_path) {
+        fprintf(stderr, "Socket path too long: %s\n", socket_path);
+        return 1;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    if (remove_stale_socket(socket_path, &addr)) {
+        return 1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    if (bind(listener, (struct sockaddr *)&addr, sizeof addr) != 0 || listen(listener, 16) != 0) {
+        perror(socket_path);
+        close(listener);
+        return 1;
+    }
+    // A client hanging up mid reply should not take the server down
+    signal(SIGPIPE, SIG_IGN);
+
+    trace_parse_threads = parse_threads;
+    if (num_workers == 0) {
+        num_workers = std::thread::hardware_concurrency();
+    }
+    if (num_workers == 0) {
+        num_workers = 1;
+    }
+    for (unsigned i = 0; i < num_workers; i++) {
+        std::thread(worker_main).detach();
+    }
+    printf("Serving on %s with %u workers\n", socket_path, num_workers);
+    fflush(stdout);
+
+    int backoff_ms = ACCEPT_BACKOFF_MIN_MS;
+    while (true) {
+        int client = accept(listener, 0, 0);
+        if (client >= 0) {
+            backoff_ms = ACCEPT_BACKOFF_MIN_MS;
+            std::thread(handle_connection, client).detach();
+            continue;
+        }
+        if (errno == EINTR || errno == ECONNABORTED) {
+            continue;
+        }
+        perror("accept");
+        if (errno != EMFILE && errno != ENFILE && errno != ENOBUFS && errno != ENOMEM) {
+            break;
+        }
+        // Retrying straight away would spin until a connection closes
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
+        if (backoff_ms < ACCEPT_BACKOFF_MAX_MS) {
+            backoff_ms *= 2;
+        }
+    }
+    close(listener);
+    unlink(socket_path);
+    return 1;
+}
@@ -0,0 +1,10 @@
+#ifndef CACHESIM_SERVER_HPP
+#define CACHESIM_SERVER_HPP
+
+// Serve simulation queries on a Unix domain socket until killed. Traces are
+// decoded once with parse_threads threads and kept resident; queries run on
+// num_workers threads (0 for either picks one per hardware thread).
+// Returns nonzero if the socket could not be set up or stops accepting.
+extern int run_server(const char *socket_path, unsigned num_workers, unsigned parse_threads);
+
+#endif /* CACHESIM_SERVER_HPP */
@@ -0,0 +1,224 @@
+"""Client for the resident sweep server started with `cachesim -S <socket>`.
+
+    client = SweepClient("/tmp/cachesim.sock")
+    client.load("gcc", "./traces/gcc.trace")
+    results = client.run([("gcc", Config(c=12, b=6, s=0)),
+                          ("gcc", Config(c=14, b=6, s=0, vipt=True, p=14, t=3, m=16))])
+
+Each result is a dict keyed by STATS_FIELDS, or a SweepError for a query the
+server rejected. Running this file starts a server on the short traces and
+exercises LOAD/SIM/RUN/UNLOAD and the error replies; `sweep_client.py lockstep`
+instead checks the server's lockstep direct mapped results against separate
+./run.sh runs (validate.sh runs both).
+"""
+import os
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+from collections import namedtuple
+
+# sim_stats_t fields in declaration order, which is the order RUN replies with
+# them. Keep in sync with cachesim.hpp.
+STATS_FIELDS = [
+    "reads", "writes",
+    "accesses_l1", "array_lookups_l1", "tag_compares_l1", "hits_l1", "misses_l1",
+    "writebacks_l1", "hit_ratio_l1", "miss_ratio_l1",
+    "accesses_tlb", "hits_tlb", "misses_tlb", "hit_ratio_tlb", "miss_ratio_tlb",
+    "accesses_hw_ivpt", "hits_hw_ivpt", "misses_hw_ivpt", "hit_ratio_hw_ivpt", "miss_ratio_hw_ivpt",
+    "cache_flush_writebacks",
+    "avg_access_time",
+]
+RATIO_FIELDS = {name for name in STATS_FIELDS if "ratio" in name or name == "avg_access_time"}
+
+# Same defaults as DEFAULT_SIM_CONFIG in cachesim.hpp
+Config = namedtuple("Config", ["c", "b", "s", "vipt", "p", "t", "m"],
+                    defaults=[12, 6, 0, False, 10, 3, 10])
+
+
+class SweepError(Exception):
+    pass
+
+
+class SweepClient:
+    def __init__(self, socket_path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(socket_path)
+        self.file = self.sock.makefile("rw")
+
+    def _send(self, line):
+        self.file.write(line + "\n")
+        self.file.flush()
+
+    def _reply(self):
+        line = self.file.readline()
+        if not line:
+            raise SweepError("server closed the connection")
+        status, _, rest = line.strip().partition(" ")
+        if status == "ERR":
+            raise SweepError(rest)
+        return rest
+
+    def load(self, name, path=None):
+        """Decode a trace on the server, returns the number of accesses"""
+        self._send(f"LOAD {name} {path}" if path else f"LOAD {name}")
+        return int(self._reply())
+
+    def unload(self, name):
+        self._send(f"UNLOAD {name}")
+        self._reply()
+
+    def run(self, queries):
+        """Run (trace name, Config) pairs as one batch, results in the same order"""
+        for name, config in queries:
+            self._send(f"SIM {name} {config.c} {config.b} {config.s} {int(config.vipt)} "
+                       f"{config.p} {config.t} {config.m}")
+        self._send("RUN")
+        results = []
+        for _ in queries:
+            try:
+                values = self._reply().split()
+            except SweepError as error:
+                results.append(error)
+                continue
+            if len(values) != len(STATS_FIELDS):
+                raise SweepError(f"expected {len(STATS_FIELDS)} fields, got {len(values)}: "
+                                 "is STATS_FIELDS out of date with sim_stats_t?")
+            results.append({name: float(value) if name in RATIO_FIELDS else int(value)
+                            for name, value in zip(STATS_FIELDS, values)})
+        return results
+
+    def close(self):
+        self._send("QUIT")
+        self.file.close()
+        self.sock.close()
+
+
+def start_server(socket_path, binary="./cachesim", workers=0):
+    """Start a server in the background and wait until it accepts connections"""
+    server = subprocess.Popen([binary, "-S", socket_path, "-w", str(workers)],
+                              stdout=subprocess.DEVNULL)
+    for _ in range(100):
+        try:
+            return server, SweepClient(socket_path)
+        except (FileNotFoundError, ConnectionRefusedError):
+            time.sleep(0.05)
+    server.kill()
+    raise SweepError(f"server did not come up on {socket_path}")
+
+
+def smoke_test(client):
+    trace = "short_traces/short_gcc.trace"
+    accesses = client.load("gcc", trace)
+    results = client.run([
+        ("gcc", Config()),
+        ("gcc", Config(c=14, s=4)),
+        ("gcc", Config(vipt=True)),
+        ("gcc", Config(c=12, b=4, s=9)),  # S > C - B
+        ("missing", Config()),
+    ])
+    for result in results[:3]:
+        assert isinstance(result, dict), result
+        assert result["accesses_l1"] == accesses
+        assert result["hits_l1"] + result["misses_l1"] == accesses
+    assert isinstance(results[3], SweepError) and "associativity" in str(results[3]), results[3]
+    assert isinstance(results[4], SweepError) and "not loaded" in str(results[4]), results[4]
+    client.unload("gcc")
+    try:
+        client.unload("gcc")
+        raise AssertionError("second UNLOAD should fail")
+    except SweepError:
+        pass
+    print(f"Sweep server smoke test passed ({accesses} accesses, "
+          f"default AAT {results[0]['avg_access_time']:.3f})")
+
+
+# Labels print_statistics uses, by the field they print
+CLI_LABELS = {
+    "Reads": "reads", "Writes": "writes",
+    "HWIVPT accesses": "accesses_hw_ivpt", "HWIVPT hits": "hits_hw_ivpt",
+    "HWIVPT misses (Page Faults)": "misses_hw_ivpt",
+    "HWIVPT hit ratio": "hit_ratio_hw_ivpt", "HWIVPT miss ratio": "miss_ratio_hw_ivpt",
+    "L1 writebacks due to OS cache flush": "cache_flush_writebacks",
+    "TLB accesses": "accesses_tlb", "TLB hits": "hits_tlb",
+    "TLB misses (Translation Faults)": "misses_tlb",
+    "TLB hit ratio": "hit_ratio_tlb", "TLB miss ratio": "miss_ratio_tlb",
+    "L1 accesses": "accesses_l1", "L1 hits": "hits_l1", "L1 misses": "misses_l1",
+    "L1 hit ratio": "hit_ratio_l1", "L1 miss ratio": "miss_ratio_l1",
+    "L1 writebacks due user level conflicts": "writebacks_l1",
+    "L1 average access time (AAT)": "avg_access_time",
+}
+
+
+def run_cli(trace, config):
+    """Statistics printed by a separate ./run.sh run, as strings keyed by field"""
+    args = ["./run.sh", "-c", str(config.c), "-b", str(config.b), "-s", str(config.s),
+            "-p", str(config.p), "-t", str(config.t), "-m", str(config.m)]
+    if config.vipt:
+        args.append("-v")
+    with open(trace) as f:
+        output = subprocess.run(args, stdin=f, capture_output=True, text=True, check=True).stdout
+    stats = {}
+    for line in output.splitlines():
+        label, _, value = line.partition(": ")
+        if label in CLI_LABELS:
+            stats[CLI_LABELS[label]] = value
+    return stats
+
+
+def lockstep_configs():
+    """Direct mapped PIPT and VIPT points, which the server runs in lockstep"""
+    configs = [Config(c=c, b=b, s=0) for c in range(9, 16) for b in range(4, 8)]
+    # A direct mapped VIPT cache needs C = P; vary T and M too so lanes only
+    # share a pass when they share the translation hardware
+    for c in range(9, 15):
+        for b in range(4, 8):
+            configs.append(Config(c=c, b=b, s=0, vipt=True, p=c, t=min(3, c - b), m=min(20, 32 - c)))
+            configs.append(Config(c=c, b=b, s=0, vipt=True, p=c, t=0, m=c))
+    # Set associative points in the same batch take the sim_access path
+    configs += [Config(c=12, b=5, s=2), Config(c=14, b=6, s=1, vipt=True, p=12, t=4, m=14)]
+    return configs
+
+
+def lockstep_check(client, traces):
+    mismatches = 0
+    for name in traces:
+        trace = f"short_traces/short_{name}.trace"
+        client.load(name, trace)
+        configs = lockstep_configs()
+        results = client.run([(name, config) for config in configs])
+        for config, result in zip(configs, results):
+            if isinstance(result, SweepError):
+                raise SweepError(f"{name} {config}: {result}")
+            for field, expected in run_cli(trace, config).items():
+                value = result[field]
+                actual = f"{value:.3f}" if field in RATIO_FIELDS else str(value)
+                if actual != expected:
+                    mismatches += 1
+                    print(f"{name} {config}: {field} is {actual}, separate run gives {expected}")
+        client.unload(name)
+        print(f"==> {name}: {len(configs)} configurations compared")
+    if mismatches:
+        raise SweepError(f"{mismatches} statistics differ from separate runs")
+    print("Matched!")
+
+
+def main():
+    socket_path = os.path.join(tempfile.mkdtemp(), "cachesim.sock")
+    server, client = start_server(socket_path)
+    try:
+        if sys.argv[1:] == ["lockstep"]:
+            lockstep_check(client, ["gcc", "mcf"])
+        else:
+            smoke_test(client)
+        client.close()
+    finally:
+        server.kill()
+        server.wait()
+        os.unlink(socket_path)
+        os.rmdir(os.path.dirname(socket_path))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,300 @@
+#include "trace.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+
+/************** Constants **************/
+
+// Below this many bytes per thread, spawning threads costs more than it saves
+static const uint64_t MIN_CHUNK_BYTES = 1 << 20;
+
+static const uint64_t ONES = 0x0101010101010101ULL;
+static const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+/************** Hex Decoding Helpers **************/
+
+/**
+ * Whitespace as matched by a scanf directive
+ */
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Value of a single hex digit, or -1 if c is not one
+ */
+static inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Set the high bit of every byte of x (all bytes < 0x80) that is >= lo
+ */
+static inline uint64_t bytes_at_least(uint64_t x, uint8_t lo) {
+    return (x + (0x80 - lo) * ONES) & HIGH_BITS;
+}
+
+/**
+ * Set the high bit of every byte of x (all bytes < 0x80) that is <= hi
+ */
+static inline uint64_t bytes_at_most(uint64_t x, uint8_t hi) {
+    return ~(x + (0x7F - hi) * ONES) & HIGH_BITS;
+}
+
+/**
+ * Decode 8 ASCII hex digits (first digit in the lowest byte) in one go.
+ * Returns false without touching value if any byte is not a hex digit.
+ */
+static inline bool decode_hex8(const char *p, uint32_t *value) {
+    uint64_t x;
+    memcpy(&x, p, sizeof x);
+    if (x & HIGH_BITS) {
+        return false;
+    }
+    uint64_t digit = bytes_at_least(x, '0') & bytes_at_most(x, '9');
+    uint64_t lower = x | (0x20 * ONES);
+    uint64_t alpha = bytes_at_least(lower, 'a') & bytes_at_most(lower, 'f');
+    if ((digit | alpha) != HIGH_BITS) {
+        return false;
+    }
+    // Letters have bit 6 set, and their low nibble is 9 short of their value
+    uint64_t v = (x & (0x0F * ONES)) + ((x >> 6) & ONES) * 9;
+    // Fold nibbles into bytes, bytes into halfwords, halfwords into a word
+    v = ((v << 4) | (v >> 8)) & 0x00FF00FF00FF00FFULL;
+    v = ((v << 8) | (v >> 16)) & 0x0000FFFF0000FFFFULL;
+    v = ((v << 16) | (v >> 32)) & 0x00000000FFFFFFFFULL;
+    *value = (uint32_t)v;
+    return true;
+}
+
+/**
+ * Convert a number the way scanf's %x does: skip whitespace, then take an
+ * optional sign, an optional 0x/0X prefix, and hex digits, saturating on
+ * overflow as strtoull does. *pp is left at the first byte not consumed.
+ * Returns false if there were no digits (the "0" of a prefix counts as one).
+ */
+static inline bool scan_hex(const char **pp, const char *end, uint64_t *value) {
+    const char *p = *pp;
+    while (p < end && is_space(*p)) p++;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+    // Only step over a "0" that starts a prefix, so a plain leading zero
+    // still lets 16 padded digits take the fast path below
+    bool any_digits = false;
+    if (end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        any_digits = true;
+        p += 2;
+    }
+
+    uint64_t v = 0;
+    bool overflow = false;
+    uint32_t hi, lo;
+    if (end - p >= 16 && decode_hex8(p, &hi) && decode_hex8(p + 8, &lo)) {
+        // Common case: the trace generators zero pad to 16 digits
+        v = ((uint64_t)hi << 32) | lo;
+        p += 16;
+        any_digits = true;
+    }
+    int digit;
+    while (p < end && (digit = hex_value(*p)) >= 0) {
+        overflow |= (v >> 60) != 0;
+        v = (v << 4) | digit;
+        p++;
+        any_digits = true;
+    }
+
+    *pp = p;
+    if (!any_digits) {
+        return false;
+    }
+    if (overflow) {
+        *value = UINT64_MAX;
+    } else {
+        *value = negative ? -v : v;
+    }
+    return true;
+}
+
+/************** Chunk Parsing **************/
+
+/**
+ * Parse every record that starts in [p, end) into out and return how many
+ * there were; a record may run on up to limit. out must have room for
+ * chunk_capacity(p, end) + 1 records. *stop is set to where the next record
+ * starts. Matches the "%c 0x%x\n" scanf the driver uses for streams: when a
+ * record does not match, the byte that broke the match starts the next one.
+ * Whitespace is only skipped after a record that matched (skip_space says
+ * whether p follows one), since %c takes whitespace like any other byte.
+ */
+static uint64_t parse_chunk(const char *p, const char *end, const char *limit,
+                            bool skip_space, trace_access_t *out, const char **stop) {
+    uint64_t count = 0;
+    while (true) {
+        if (skip_space) {
+            while (p < limit && is_space(*p)) p++;
+        }
+        if (p >= end) {
+            break;
+        }
+        char rw = *p++;
+        skip_space = false;
+        while (p < limit && is_space(*p)) p++;
+        // Like scanf, a partial "0x" consumes what did match
+        if (p < limit && *p == '0') {
+            p++;
+        } else {
+            continue;
+        }
+        if (p < limit && *p == 'x') {
+            p++;
+        } else {
+            continue;
+        }
+
+        uint64_t addr;
+        if (!scan_hex(&p, limit, &addr)) {
+            continue;
+        }
+
+        out[count].addr = addr;
+        out[count].rw = rw;
+        count++;
+        skip_space = true;
+    }
+    *stop = p;
+    return count;
+}
+
+/**
+ * Upper bound on the records in [p, end), bar one that runs past end: each
+ * one consumes its own "0x", so there are at most as many as there are 'x'
+ * bytes. For a well formed trace this is exactly the number of lines.
+ */
+static uint64_t chunk_capacity(const char *p, const char *end) {
+    uint64_t count = 0;
+    while ((p = (const char *)memchr(p, 'x', end - p)) != 0) {
+        count++;
+        p++;
+    }
+    return count;
+}
+
+/**
+ * First byte of the line following the one containing pos
+ */
+static const char *next_line(const char *pos, const char *end) {
+    const char *newline = (const char *)memchr(pos, '\n', end - pos);
+    return (newline == 0) ? end : newline + 1;
+}
+
+/************** Public Interface **************/
+
+int trace_parse_fd(int fd, unsigned num_threads, trace_t *trace) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return -1;
+    }
+    trace->accesses = 0;
+    trace->length = 0;
+    uint64_t size = st.st_size;
+    if (size == 0) {
+        return 0;
+    }
+
+    void *map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    const char *base = (const char *)map;
+    const char *end = base + size;
+
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+    uint64_t max_threads = size / MIN_CHUNK_BYTES;
+    if (num_threads > max_threads) num_threads = max_threads;
+    if (num_threads == 0) num_threads = 1;
+
+    // Split on line boundaries so every line belongs to exactly one chunk
+    std::vector<const char *> bounds(num_threads + 1);
+    bounds[0] = base;
+    bounds[num_threads] = end;
+    for (unsigned i = 1; i < num_threads; i++) {
+        const char *guess = base + size * i / num_threads;
+        if (guess < bounds[i - 1]) guess = bounds[i - 1];
+        bounds[i] = next_line(guess, end);
+    }
+
+    // Size every chunk first so all of them decode straight into one buffer,
+    // rather than into per chunk buffers that are copied together afterwards
+    std::vector<uint64_t> offsets(num_threads + 1, 0);
+    std::vector<uint64_t> counts(num_threads, 0);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < num_threads; i++) {
+        workers.emplace_back([&bounds, &counts, i]() {
+            counts[i] = chunk_capacity(bounds[i], bounds[i + 1]);
+        });
+    }
+    for (unsigned i = 0; i < num_threads; i++) {
+        workers[i].join();
+        offsets[i + 1] = offsets[i] + counts[i] + 1;
+    }
+
+    trace_access_t *accesses = (trace_access_t *)malloc(offsets[num_threads] * sizeof(trace_access_t));
+    if (accesses == 0) {
+        munmap(map, size);
+        return -1;
+    }
+
+    // Chunks after the first assume the line before them ended in a record
+    // that matched. When a record runs over a boundary, or a mismatch leaves
+    // the next record starting on whitespace, the chunk after it is parsed
+    // again from where the previous one actually stopped.
+    std::vector<const char *> stops(num_threads);
+    workers.clear();
+    for (unsigned i = 0; i < num_threads; i++) {
+        workers.emplace_back([&bounds, &counts, &offsets, &stops, accesses, end, i]() {
+            counts[i] = parse_chunk(bounds[i], bounds[i + 1], end, i > 0, accesses + offsets[i], &stops[i]);
+        });
+    }
+    for (unsigned i = 0; i < num_threads; i++) {
+        workers[i].join();
+    }
+    for (unsigned i = 1; i < num_threads; i++) {
+        const char *start = bounds[i];
+        while (start < end && is_space(*start)) start++;
+        if (stops[i - 1] != start) {
+            counts[i] = parse_chunk(stops[i - 1], bounds[i + 1], end, false, accesses + offsets[i], &stops[i]);
+        }
+    }
+    munmap(map, size);
+
+    // Close the gaps left by malformed records, keeping file order
+    uint64_t length = counts[0];
+    for (unsigned i = 1; i < num_threads; i++) {
+        if (offsets[i] != length) {
+            memmove(accesses + length, accesses + offsets[i], counts[i] * sizeof(trace_access_t));
+        }
+        length += counts[i];
+    }
+    trace->accesses = accesses;
+    trace->length = length;
+    return 0;
+}
+
+void trace_free(trace_t *trace) {
+    free(trace->accesses);
+    trace->accesses = 0;
+    trace->length = 0;
+}
@@ -0,0 +1,26 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <stdint.h>
+
+// One decoded line of a text trace ("R 0x%016x")
+typedef struct trace_access {
+    uint64_t addr;
+    char rw;
+} trace_access_t;
+
+// A whole trace decoded into memory, in file order
+typedef struct trace {
+    trace_access_t *accesses;
+    uint64_t length;
+} trace_t;
+
+// Decode the text trace behind fd using up to num_threads parser threads
+// (0 picks one per hardware thread). Returns 0 on success, or -1 if the
+// trace cannot be decoded in memory: fd is not a regular file that can be
+// mapped (e.g. a pipe), or the decoded trace does not fit. The caller can
+// then fall back to reading the stream.
+extern int trace_parse_fd(int fd, unsigned num_threads, trace_t *trace);
+extern void trace_free(trace_t *trace);
+
+#endif /* TRACE_HPP */
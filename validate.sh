@@ -64,6 +64,35 @@ generate_stats_and_diff() {
     fi
 }
 
+# Records the stream parser's "%c 0x%x\n" scanf reads in odd ways. Each one
+# is followed by a well formed record, so a parser that disagrees with scanf
+# over how much a bad record consumes also changes the access count.
+malformed_trace() {
+    printf 'R 0x  00000000deadbeef\nW 0x0000000000000040\n'
+    printf 'R 0x+40\nR 0x0000000000000040\n'
+    printf 'W 0x0x0000000000001000\nR 0x0000000000001000\n'
+    printf 'R 0x-40\nR 0xffffffffffffffc0\n'
+    printf 'W 0x1000000000000000000\nR 0xffffffffffffffff\n'
+    printf 'R  0x0000560feb6d7f7g\nW 0x1\n'
+    printf 'R 0x\t7\n \tW 0x0000000000000080\n'
+}
+
+# The trace is decoded up front from a file but scanned as it arrives from a
+# pipe, and both must give the same statistics
+parse_file_and_pipe_and_diff() {
+    local trace
+    trace=$(mktemp)
+    malformed_trace >"$trace"
+    ./run.sh <"$trace" >"${student_stat_dir}/malformed_file.out"
+    cat "$trace" | ./run.sh >"${student_stat_dir}/malformed_pipe.out"
+    rm -f "$trace"
+    if diff -u "${student_stat_dir}/malformed_pipe.out" "${student_stat_dir}/malformed_file.out"; then
+        printf 'Matched!\n\n'
+    else
+        printf '\nPlease examine the differences printed above. Decoding the trace from a file disagrees with reading it from a pipe\n\n'
+    fi
+}
+
 main() {
     mkdir -p "$student_stat_dir"
 
@@ -88,6 +117,16 @@ main() {
     for benchmark in "${default_benchmarks[@]}"; do
         generate_stats_and_diff l1_vipt "$benchmark"
     done
+
+    banner "Testing malformed traces read from a file and from a pipe..."
+    parse_file_and_pipe_and_diff
+
+    banner "Testing the sweep server..."
+    python3 sweep_client.py
+    printf '\n'
+
+    banner "Testing lockstep direct mapped sweeps against separate runs..."
+    python3 sweep_client.py lockstep
 }
 
 main